@@ -8,6 +8,187 @@
 #include <time.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+typedef struct lumen_downsample_job{
+	lumen_downsample_pool* pool;
+	uint32_t band;
+}lumen_downsample_job;
+
+struct lumen_downsample_pool{
+	lumen_renderer* renderer;
+	pthread_t threads[DOWNSAMPLE_THREAD_COUNT];
+	lumen_downsample_job jobs[DOWNSAMPLE_THREAD_COUNT];
+	// bands per frame, the calling thread takes band 0 and workers the rest
+	uint32_t count;
+	uint32_t generation;
+	uint32_t pending;
+	uint8_t stop;
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+};
+
+static void lumen_downsample_rows(lumen_renderer* renderer, uint32_t row_start, uint32_t row_end){
+	// box filter, each output channel is the rounded mean of its scale*scale block
+	uint32_t scale = renderer->scale;
+	uint32_t w = renderer->present_w;
+	uint32_t stride = renderer->w;
+	uint32_t area = scale*scale;
+	uint32_t y, x, i, k;
+	for (y = row_start;y<row_end;++y){
+		uint32_t* out = renderer->present+(y*w);
+		uint32_t* in = renderer->pixels+(y*scale*stride);
+		x = 0;
+#ifdef __SSE2__
+		__m128i zero = _mm_setzero_si128();
+		if (scale == 2){
+			__m128i round = _mm_set1_epi16(2);
+			for (;x+2<=w;x+=2){
+				__m128i a = _mm_loadu_si128((__m128i*)(in+(x*2)));
+				__m128i b = _mm_loadu_si128((__m128i*)(in+stride+(x*2)));
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+				lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+				hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+				__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+				_mm_storel_epi64((__m128i*)(out+x), _mm_packus_epi16(sum, zero));
+			}
+		}
+		else if (scale == 4){
+			__m128i round = _mm_set1_epi16(8);
+			for (;x<w;++x){
+				__m128i lo = zero;
+				__m128i hi = zero;
+				for (i = 0;i<4;++i){
+					__m128i a = _mm_loadu_si128((__m128i*)(in+(i*stride)+(x*4)));
+					lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(a, zero));
+					hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(a, zero));
+				}
+				lo = _mm_add_epi16(lo, hi);
+				lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+				__m128i sum = _mm_srli_epi16(_mm_add_epi16(lo, round), 4);
+				out[x] = _mm_cvtsi128_si32(_mm_packus_epi16(sum, zero));
+			}
+		}
+#endif
+		for (;x<w;++x){
+			uint32_t r = 0, g = 0, b = 0, a = 0;
+			for (i = 0;i<scale;++i){
+				uint32_t* sample = in+(i*stride)+(x*scale);
+				for (k = 0;k<scale;++k){
+					r += (sample[k] >> 24) & 0xff;
+					g += (sample[k] >> 16) & 0xff;
+					b += (sample[k] >> 8) & 0xff;
+					a += sample[k] & 0xff;
+				}
+			}
+			r = (r+(area/2))/area;
+			g = (g+(area/2))/area;
+			b = (b+(area/2))/area;
+			a = (a+(area/2))/area;
+			out[x] = (r << 24) + (g << 16) + (b << 8) + a;
+		}
+	}
+}
+
+static void lumen_downsample_band(lumen_downsample_pool* pool, uint32_t band){
+	uint32_t h = pool->renderer->present_h;
+	lumen_downsample_rows(pool->renderer, (h*band)/pool->count, (h*(band+1))/pool->count);
+}
+
+static void* lumen_downsample_worker(void* arg){
+	lumen_downsample_job* job = arg;
+	lumen_downsample_pool* pool = job->pool;
+	uint32_t seen = 0;
+	pthread_mutex_lock(&pool->lock);
+	for (;;){
+		while (pool->generation == seen && !pool->stop){
+			pthread_cond_wait(&pool->start, &pool->lock);
+		}
+		if (pool->stop) break;
+		seen = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+		lumen_downsample_band(pool, job->band);
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->pending == 0){
+			pthread_cond_signal(&pool->done);
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+static void lumen_downsample_pool_start(lumen_renderer* renderer){
+	// workers live as long as the renderer, only worth it with spare cores and enough rows per band
+	renderer->downsample = NULL;
+	uint32_t count = renderer->present_h/DOWNSAMPLE_THREAD_MIN_ROWS;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > DOWNSAMPLE_THREAD_COUNT) count = DOWNSAMPLE_THREAD_COUNT;
+	if (cores > 0 && count > (uint32_t)cores) count = cores;
+	if (count < 2) return;
+	lumen_downsample_pool* pool = malloc(sizeof(lumen_downsample_pool));
+	pool->renderer = renderer;
+	pool->count = 1;
+	pool->generation = 0;
+	pool->pending = 0;
+	pool->stop = 0;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->start, NULL);
+	pthread_cond_init(&pool->done, NULL);
+	uint32_t i;
+	for (i = 1;i<count;++i){
+		pool->jobs[i].pool = pool;
+		pool->jobs[i].band = i;
+		if (pthread_create(&pool->threads[i], NULL, lumen_downsample_worker, &pool->jobs[i]) != 0) break;
+		pool->count++;
+	}
+	renderer->downsample = pool;
+}
+
+static void lumen_downsample_pool_stop(lumen_renderer* renderer){
+	lumen_downsample_pool* pool = renderer->downsample;
+	if (pool == NULL) return;
+	pthread_mutex_lock(&pool->lock);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	uint32_t i;
+	for (i = 1;i<pool->count;++i){
+		pthread_join(pool->threads[i], NULL);
+	}
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->done);
+	free(pool);
+	renderer->downsample = NULL;
+}
+
+void lumen_render_downsample(lumen_renderer* renderer){
+	if (renderer->scale <= 1) return;
+	lumen_downsample_pool* pool = renderer->downsample;
+	if (pool == NULL || pool->count < 2){
+		lumen_downsample_rows(renderer, 0, renderer->present_h);
+		return;
+	}
+	pthread_mutex_lock(&pool->lock);
+	pool->renderer = renderer;
+	pool->pending = pool->count-1;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	lumen_downsample_band(pool, 0);
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending != 0){
+		pthread_cond_wait(&pool->done, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
 
 void lumen_renderer_init(lumen_renderer* renderer, uint32_t w, uint32_t h){
 	renderer->pixels = calloc(w*h,sizeof(uint32_t));
@@ -15,30 +196,87 @@ void lumen_renderer_init(lumen_renderer* renderer, uint32_t w, uint32_t h){
 	renderer->h = h;
 	renderer->render_color = 0xffffffff;
 	renderer->blendmode = LUMEN_BLENDMODE_ALPHA;
+	renderer->present = renderer->pixels;
+	renderer->present_w = w;
+	renderer->present_h = h;
+	renderer->scale = 1;
+	renderer->text = NULL;
+	renderer->text_color = NULL;
+	renderer->shared = NULL;
+	renderer->shared_size = 0;
+	renderer->shared_name = NULL;
+	renderer->downsample = NULL;
+}
+
+void lumen_renderer_init_supersampled(lumen_renderer* renderer, uint32_t w, uint32_t h, uint32_t scale){
+	// draw calls work at w*scale by h*scale, put reduces back to w by h
+	if (scale == 0) scale = 1;
+	lumen_renderer_init(renderer, w*scale, h*scale);
+	renderer->present_w = w;
+	renderer->present_h = h;
+	renderer->scale = scale;
+	if (scale > 1){
+		renderer->present = calloc(w*h,sizeof(uint32_t));
+		lumen_downsample_pool_start(renderer);
+	}
 }
 
 void lumen_renderer_free(lumen_renderer* renderer){
-	free(renderer->pixels);
+	lumen_downsample_pool_stop(renderer);
+	if (renderer->shared != NULL){
+		// present, and pixels when not supersampled, live in the mapping
+		if (renderer->present != renderer->pixels){
+			free(renderer->pixels);
+		}
+		munmap(renderer->shared, renderer->shared_size);
+		shm_unlink(renderer->shared_name);
+		free(renderer->shared_name);
+		renderer->shared = NULL;
+		renderer->shared_name = NULL;
+	}
+	else{
+		if (renderer->present != renderer->pixels){
+			free(renderer->present);
+		}
+		free(renderer->pixels);
+	}
+	free(renderer->text);
+	free(renderer->text_color);
+	renderer->present = NULL;
+	renderer->pixels = NULL;
+	renderer->text = NULL;
+	renderer->text_color = NULL;
 }
 
 void lumen_render_reset(lumen_renderer* renderer){
 	memset(renderer->pixels, 0, renderer->w*renderer->h*sizeof(uint32_t));
+	if (renderer->text != NULL){
+		memset(renderer->text, 0, renderer->present_w*renderer->present_h*2);
+	}
 }
 
 void lumen_render_put(lumen_renderer* renderer){
+	lumen_render_downsample(renderer);
 	char* reset_prompt = A_CURSOR_HOME;
-	printf(reset_prompt);
+	fputs(reset_prompt, stdout);
 	uint32_t x, y;
 	char* endline = "\n\r";
 	char* clear = "\033[0m";
-	size_t cap = renderer->w*renderer->h;
+	size_t cap = renderer->present_w*renderer->present_h;
 	size_t len = 0;
 	char* line = malloc(cap);
 	strcpy(line, "");
-	for (y=0;y<renderer->h;++y){
-		uint32_t row = y*renderer->w;
-		for (x=0;x<renderer->w;++x){
-			char* ascii_pixel = lumen_ascii_convert(renderer->pixels[row+x]);
+	for (y=0;y<renderer->present_h;++y){
+		uint32_t row = y*renderer->present_w;
+		for (x=0;x<renderer->present_w;++x){
+			char* ascii_pixel;
+			size_t cell = (row+x)*2;
+			if (renderer->text != NULL && (renderer->text[cell] != '\0' || renderer->text[cell+1] != '\0')){
+				ascii_pixel = lumen_ascii_convert_text(renderer->text_color[row+x], renderer->text[cell], renderer->text[cell+1]);
+			}
+			else{
+				ascii_pixel = lumen_ascii_convert(renderer->present[row+x]);
+			}
 			len += strlen(ascii_pixel);
 			if (len >= cap){
 				line = realloc(line, len+1);
@@ -54,9 +292,448 @@ void lumen_render_put(lumen_renderer* renderer){
 		}
 		strcat(line, endline);
 	}
-	printf(line);
+	fputs(line, stdout);
 	free(line);
-	printf(clear);
+	fputs(clear, stdout);
+}
+
+static uint32_t* lumen_shm_slot(lumen_shm_header* header, uint32_t slot){
+	return (uint32_t*)(header+1)+(slot*header->w*header->h);
+}
+
+int32_t lumen_renderer_share(lumen_renderer* renderer, const char* name){
+	// name follows shm_open rules, a single leading slash, and must not exist yet
+	if (renderer->shared != NULL){
+		fprintf(stderr, "\033[1mLumen\033[0m renderer is already shared as %s\n", renderer->shared_name);
+		return -1;
+	}
+	uint32_t w = renderer->present_w;
+	uint32_t h = renderer->present_h;
+	size_t size = sizeof(lumen_shm_header)+(2*w*h*sizeof(uint32_t));
+	// exclusive create, so the unlinks below only ever remove a segment made here
+	int32_t fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd == -1){
+		fprintf(stderr, "\033[1mLumen\033[0m could not create shared memory %s, it may already exist\n", name);
+		return -1;
+	}
+	if (ftruncate(fd, size) == -1){
+		fprintf(stderr, "\033[1mLumen\033[0m could not size shared memory %s\n", name);
+		close(fd);
+		shm_unlink(name);
+		return -1;
+	}
+	lumen_shm_header* header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (header == MAP_FAILED){
+		fprintf(stderr, "\033[1mLumen\033[0m could not map shared memory %s\n", name);
+		shm_unlink(name);
+		return -1;
+	}
+	header->magic = 0;
+	header->w = w;
+	header->h = h;
+	header->front = 0;
+	header->frame = 0;
+	header->sequence = 0;
+	uint32_t* back = lumen_shm_slot(header, 1);
+	memcpy(back, renderer->present, w*h*sizeof(uint32_t));
+	memcpy(lumen_shm_slot(header, 0), back, w*h*sizeof(uint32_t));
+	if (renderer->present == renderer->pixels){
+		free(renderer->pixels);
+		renderer->pixels = back;
+	}
+	else{
+		free(renderer->present);
+	}
+	renderer->present = back;
+	renderer->shared = header;
+	renderer->shared_size = size;
+	renderer->shared_name = strdup(name);
+	__atomic_store_n(&header->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void lumen_render_publish(lumen_renderer* renderer){
+	// seqlock swap, readers that copied a slot across a swap see the sequence move and retry
+	lumen_render_downsample(renderer);
+	lumen_shm_header* header = renderer->shared;
+	if (header == NULL) return;
+	uint32_t sequence = header->sequence;
+	uint32_t back = header->front^1;
+	__atomic_store_n(&header->sequence, sequence+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&header->front, back, __ATOMIC_RELAXED);
+	__atomic_store_n(&header->frame, header->frame+1, __ATOMIC_RELAXED);
+	__atomic_store_n(&header->sequence, sequence+2, __ATOMIC_RELEASE);
+	// the old front slot is written from here on, those stores must not become visible before the sequence does
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	// keep drawing on top of the frame just published, as with a private buffer
+	uint32_t* next = lumen_shm_slot(header, back^1);
+	memcpy(next, renderer->present, header->w*header->h*sizeof(uint32_t));
+	if (renderer->present == renderer->pixels){
+		renderer->pixels = next;
+	}
+	renderer->present = next;
+}
+
+int32_t lumen_shm_reader_open(lumen_shm_reader* reader, const char* name){
+	reader->header = NULL;
+	reader->size = 0;
+	reader->frame = 0;
+	int32_t fd = shm_open(name, O_RDONLY, 0);
+	if (fd == -1){
+		fprintf(stderr, "\033[1mLumen\033[0m could not open shared memory %s\n", name);
+		return -1;
+	}
+	struct stat info;
+	if (fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(lumen_shm_header)){
+		fprintf(stderr, "\033[1mLumen\033[0m shared memory %s is not a lumen framebuffer\n", name);
+		close(fd);
+		return -1;
+	}
+	lumen_shm_header* header = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (header == MAP_FAILED){
+		fprintf(stderr, "\033[1mLumen\033[0m could not map shared memory %s\n", name);
+		return -1;
+	}
+	size_t expected = sizeof(lumen_shm_header)+(2*header->w*header->h*sizeof(uint32_t));
+	if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC || expected > (size_t)info.st_size){
+		fprintf(stderr, "\033[1mLumen\033[0m shared memory %s is not a lumen framebuffer\n", name);
+		munmap(header, info.st_size);
+		return -1;
+	}
+	reader->header = header;
+	reader->size = info.st_size;
+	return 0;
+}
+
+uint8_t lumen_shm_reader_read(lumen_shm_reader* reader, uint32_t* dest){
+	// copies the newest frame into dest (header w*h pixels), 0 if nothing new or the writer kept swapping
+	lumen_shm_header* header = reader->header;
+	uint32_t attempt;
+	for (attempt = 0;attempt<SHM_READ_RETRIES;++attempt){
+		uint32_t before = __atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE);
+		if (before & 1) continue;
+		uint32_t front = __atomic_load_n(&header->front, __ATOMIC_RELAXED);
+		uint64_t frame = __atomic_load_n(&header->frame, __ATOMIC_RELAXED);
+		if (frame == reader->frame) return 0;
+		memcpy(dest, lumen_shm_slot(header, front), header->w*header->h*sizeof(uint32_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&header->sequence, __ATOMIC_RELAXED) == before){
+			reader->frame = frame;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void lumen_shm_reader_close(lumen_shm_reader* reader){
+	if (reader->header != NULL){
+		munmap(reader->header, reader->size);
+	}
+	reader->header = NULL;
+	reader->size = 0;
+}
+
+static uint32_t lumen_record_encode(const uint32_t* delta, uint32_t n, uint32_t* out){
+	// tokens: literal count followed by that many words, or high bit | count followed by one repeated word
+	uint32_t i = 0, literal = 0, len = 0;
+	while (i<n){
+		uint32_t run = 1;
+		while (i+run<n && delta[i+run] == delta[i] && run<0x7fffffff) ++run;
+		if (run < 3){
+			if (literal == 0) literal = i+1;
+			i += run;
+			continue;
+		}
+		if (literal != 0){
+			uint32_t start = literal-1;
+			out[len++] = i-start;
+			memcpy(out+len, delta+start, (i-start)*sizeof(uint32_t));
+			len += i-start;
+			literal = 0;
+		}
+		out[len++] = 0x80000000 | run;
+		out[len++] = delta[i];
+		i += run;
+	}
+	if (literal != 0){
+		uint32_t start = literal-1;
+		out[len++] = n-start;
+		memcpy(out+len, delta+start, (n-start)*sizeof(uint32_t));
+		len += n-start;
+	}
+	return len;
+}
+
+static void lumen_record_decode(const uint32_t* in, uint32_t len, uint32_t* frame, uint32_t n){
+	// xors the delta onto frame, zero runs are skipped outright
+	uint32_t i = 0, k = 0;
+	while (i<len){
+		uint32_t token = in[i++];
+		uint32_t count = token & 0x7fffffff;
+		if (k+count > n) count = n-k;
+		if (token & 0x80000000){
+			if (i >= len) return;
+			uint32_t word = in[i++];
+			if (word != 0){
+				uint32_t end = k+count;
+				for (;k<end;++k) frame[k] ^= word;
+			}
+			else{
+				k += count;
+			}
+			continue;
+		}
+		if (count > len-i) count = len-i;
+		uint32_t end = k+count;
+		for (;k<end;++k) frame[k] ^= in[i++];
+	}
+}
+
+static void lumen_recorder_flush(lumen_recorder* recorder){
+	if (recorder->batch_len == 0) return;
+	fwrite(recorder->batch, 1, recorder->batch_len, recorder->file);
+	recorder->batch_len = 0;
+}
+
+static void lumen_recorder_write(lumen_recorder* recorder, const void* data, size_t size){
+	if (recorder->batch_len+size > RECORD_WRITE_BATCH){
+		lumen_recorder_flush(recorder);
+		if (size > RECORD_WRITE_BATCH){
+			fwrite(data, 1, size, recorder->file);
+			recorder->offset += size;
+			return;
+		}
+	}
+	memcpy(recorder->batch+recorder->batch_len, data, size);
+	recorder->batch_len += size;
+	recorder->offset += size;
+}
+
+static void lumen_recorder_encode_frame(lumen_recorder* recorder, uint32_t* frame){
+	uint32_t n = recorder->header.w*recorder->header.h;
+	uint32_t count = recorder->header.frame_count;
+	uint32_t k;
+	if (count == recorder->index_cap){
+		recorder->index_cap *= 2;
+		recorder->index = realloc(recorder->index, sizeof(uint64_t)*recorder->index_cap);
+	}
+	recorder->index[count] = recorder->offset;
+	if (count % RECORD_KEYFRAME_INTERVAL == 0){
+		memset(recorder->previous, 0, n*sizeof(uint32_t));
+	}
+	// the queue slot becomes the delta, previous takes the frame itself
+	for (k = 0;k<n;++k){
+		uint32_t pixel = frame[k];
+		frame[k] ^= recorder->previous[k];
+		recorder->previous[k] = pixel;
+	}
+	uint32_t len = lumen_record_encode(frame, n, recorder->encoded);
+	lumen_recorder_write(recorder, &len, sizeof(uint32_t));
+	lumen_recorder_write(recorder, recorder->encoded, len*sizeof(uint32_t));
+	recorder->header.frame_count++;
+}
+
+static void* lumen_recorder_worker(void* arg){
+	lumen_recorder* recorder = arg;
+	uint32_t n = recorder->header.w*recorder->header.h;
+	for (;;){
+		pthread_mutex_lock(&recorder->lock);
+		while (recorder->queued == 0 && recorder->running){
+			pthread_cond_wait(&recorder->ready, &recorder->lock);
+		}
+		if (recorder->queued == 0){
+			pthread_mutex_unlock(&recorder->lock);
+			break;
+		}
+		uint32_t* frame = recorder->queue+(recorder->queue_tail*n);
+		pthread_mutex_unlock(&recorder->lock);
+		lumen_recorder_encode_frame(recorder, frame);
+		pthread_mutex_lock(&recorder->lock);
+		recorder->queue_tail = (recorder->queue_tail+1)%RECORD_QUEUE_FRAMES;
+		recorder->queued--;
+		pthread_mutex_unlock(&recorder->lock);
+	}
+	lumen_recorder_flush(recorder);
+	return NULL;
+}
+
+int32_t lumen_recorder_open(lumen_recorder* recorder, const char* dest, uint32_t w, uint32_t h){
+	// frames are w by h, normally the presented size of the renderer being captured
+	recorder->file = fopen(dest, "wb");
+	if (recorder->file == NULL){
+		fprintf(stderr, "\033[1mLumen\033[0m tried to open recording %s, but encountered an error\n", dest);
+		return -1;
+	}
+	uint32_t n = w*h;
+	recorder->header.magic = RECORD_MAGIC;
+	recorder->header.version = RECORD_VERSION;
+	recorder->header.w = w;
+	recorder->header.h = h;
+	recorder->header.frame_count = 0;
+	recorder->header.keyframe_interval = RECORD_KEYFRAME_INTERVAL;
+	recorder->header.index_offset = 0;
+	recorder->queue = malloc(sizeof(uint32_t)*n*RECORD_QUEUE_FRAMES);
+	recorder->queue_head = 0;
+	recorder->queue_tail = 0;
+	recorder->queued = 0;
+	recorder->dropped = 0;
+	recorder->previous = calloc(n, sizeof(uint32_t));
+	// worst case every third word opens a new token
+	recorder->encoded = malloc(sizeof(uint32_t)*((2*n)+2));
+	recorder->batch = malloc(RECORD_WRITE_BATCH);
+	recorder->batch_len = 0;
+	recorder->index_cap = RECORD_KEYFRAME_INTERVAL;
+	recorder->index = malloc(sizeof(uint64_t)*recorder->index_cap);
+	fwrite(&recorder->header, sizeof(lumen_record_header), 1, recorder->file);
+	recorder->offset = sizeof(lumen_record_header);
+	pthread_mutex_init(&recorder->lock, NULL);
+	pthread_cond_init(&recorder->ready, NULL);
+	recorder->running = 1;
+	if (pthread_create(&recorder->thread, NULL, lumen_recorder_worker, recorder) != 0){
+		fprintf(stderr, "\033[1mLumen\033[0m could not start the recording thread\n");
+		recorder->running = 0;
+		lumen_recorder_close(recorder);
+		return -1;
+	}
+	return 0;
+}
+
+void lumen_recorder_capture(lumen_recorder* recorder, lumen_renderer* renderer){
+	// copies the presented frame and returns, frames are dropped rather than waited on when the writer falls behind
+	uint32_t n = recorder->header.w*recorder->header.h;
+	if (renderer->present_w != recorder->header.w || renderer->present_h != recorder->header.h) return;
+	pthread_mutex_lock(&recorder->lock);
+	if (recorder->queued == RECORD_QUEUE_FRAMES || !recorder->running){
+		recorder->dropped++;
+		pthread_mutex_unlock(&recorder->lock);
+		return;
+	}
+	uint32_t* slot = recorder->queue+(recorder->queue_head*n);
+	pthread_mutex_unlock(&recorder->lock);
+	memcpy(slot, renderer->present, n*sizeof(uint32_t));
+	pthread_mutex_lock(&recorder->lock);
+	recorder->queue_head = (recorder->queue_head+1)%RECORD_QUEUE_FRAMES;
+	recorder->queued++;
+	pthread_cond_signal(&recorder->ready);
+	pthread_mutex_unlock(&recorder->lock);
+}
+
+void lumen_recorder_close(lumen_recorder* recorder){
+	if (recorder->running){
+		pthread_mutex_lock(&recorder->lock);
+		recorder->running = 0;
+		pthread_cond_signal(&recorder->ready);
+		pthread_mutex_unlock(&recorder->lock);
+		pthread_join(recorder->thread, NULL);
+	}
+	if (recorder->file != NULL){
+		recorder->header.index_offset = recorder->offset;
+		fwrite(recorder->index, sizeof(uint64_t), recorder->header.frame_count, recorder->file);
+		fseek(recorder->file, 0, SEEK_SET);
+		fwrite(&recorder->header, sizeof(lumen_record_header), 1, recorder->file);
+		fclose(recorder->file);
+		recorder->file = NULL;
+	}
+	if (recorder->dropped != 0){
+		fprintf(stderr, "\033[1mLumen\033[0m dropped %u frames while recording\n", recorder->dropped);
+	}
+	pthread_mutex_destroy(&recorder->lock);
+	pthread_cond_destroy(&recorder->ready);
+	free(recorder->queue);
+	free(recorder->previous);
+	free(recorder->encoded);
+	free(recorder->batch);
+	free(recorder->index);
+	recorder->queue = NULL;
+	recorder->previous = NULL;
+	recorder->encoded = NULL;
+	recorder->batch = NULL;
+	recorder->index = NULL;
+}
+
+int32_t lumen_player_open(lumen_player* player, const char* src){
+	player->index = NULL;
+	player->frame = NULL;
+	player->encoded = NULL;
+	player->current = 0;
+	player->file = fopen(src, "rb");
+	if (player->file == NULL){
+		fprintf(stderr, "\033[1mLumen\033[0m tried to open recording %s, but encountered an error\n", src);
+		return -1;
+	}
+	lumen_record_header* header = &player->header;
+	if (
+		fread(header, sizeof(lumen_record_header), 1, player->file) != 1 ||
+		header->magic != RECORD_MAGIC ||
+		header->version != RECORD_VERSION ||
+		header->index_offset == 0 ||
+		header->keyframe_interval == 0
+	){
+		fprintf(stderr, "\033[1mLumen\033[0m %s is not a complete lumen recording\n", src);
+		fclose(player->file);
+		player->file = NULL;
+		return -1;
+	}
+	uint32_t n = header->w*header->h;
+	player->index = malloc(sizeof(uint64_t)*(header->frame_count+1));
+	fseek(player->file, header->index_offset, SEEK_SET);
+	if (fread(player->index, sizeof(uint64_t), header->frame_count, player->file) != header->frame_count){
+		fprintf(stderr, "\033[1mLumen\033[0m %s has a damaged frame index\n", src);
+		lumen_player_close(player);
+		return -1;
+	}
+	player->frame = calloc(n, sizeof(uint32_t));
+	player->encoded = malloc(sizeof(uint32_t)*((2*n)+2));
+	lumen_player_seek(player, 0);
+	return 0;
+}
+
+static uint8_t lumen_player_decode(lumen_player* player){
+	uint32_t n = player->header.w*player->header.h;
+	uint32_t len;
+	if (player->current >= player->header.frame_count) return 0;
+	if (fread(&len, sizeof(uint32_t), 1, player->file) != 1 || len > (2*n)+2) return 0;
+	if (fread(player->encoded, sizeof(uint32_t), len, player->file) != len) return 0;
+	if (player->current % player->header.keyframe_interval == 0){
+		memset(player->frame, 0, n*sizeof(uint32_t));
+	}
+	lumen_record_decode(player->encoded, len, player->frame, n);
+	player->current++;
+	return 1;
+}
+
+uint8_t lumen_player_next(lumen_player* player, lumen_renderer* renderer){
+	// renderer must be w by h at scale 1, lumen_render_put then shows the frame
+	if (renderer->w != player->header.w || renderer->h != player->header.h) return 0;
+	if (!lumen_player_decode(player)) return 0;
+	memcpy(renderer->pixels, player->frame, player->header.w*player->header.h*sizeof(uint32_t));
+	return 1;
+}
+
+void lumen_player_seek(lumen_player* player, uint32_t frame){
+	// decode forward from the keyframe at or before frame, next then returns frame itself
+	if (player->header.frame_count == 0) return;
+	if (frame >= player->header.frame_count) frame = player->header.frame_count-1;
+	uint32_t keyframe = frame-(frame%player->header.keyframe_interval);
+	fseek(player->file, player->index[keyframe], SEEK_SET);
+	player->current = keyframe;
+	while (player->current < frame && lumen_player_decode(player)){}
+}
+
+void lumen_player_close(lumen_player* player){
+	if (player->file != NULL){
+		fclose(player->file);
+	}
+	free(player->index);
+	free(player->frame);
+	free(player->encoded);
+	player->file = NULL;
+	player->index = NULL;
+	player->frame = NULL;
+	player->encoded = NULL;
 }
 
 char* get_ascii_esc_from_color(uint32_t color){
@@ -92,6 +769,19 @@ char* lumen_ascii_convert(uint32_t pixel){
 	return output;
 }
 
+char* lumen_ascii_convert_text(uint32_t color, char left, char right){
+	// control characters would move the cursor or start escapes, show them as blanks
+	if ((uint8_t)left < 0x20 || left == 0x7f) left = ' ';
+	if ((uint8_t)right < 0x20 || right == 0x7f) right = ' ';
+	char* output = malloc(16);
+	strcpy(output, "\033[1;");
+	strcat(output, get_ascii_esc_from_color(color));
+	strcat(output, "m  ");
+	output[strlen(output)-2] = left;
+	output[strlen(output)-1] = right;
+	return output;
+}
+
 void lumen_render_set_pixel(lumen_renderer* renderer, uint32_t x, uint32_t y, uint32_t pixel){
 	if (x > renderer->w || y > renderer->h) return;
 	uint32_t background = renderer->pixels[(y*renderer->w)+x];
@@ -142,23 +832,38 @@ void lumen_render_draw_line(lumen_renderer* renderer, uint32_t x1, uint32_t y1,
 	}
 }
 
-void lumen_render_draw_circle(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r){
-	int32_t xx = -r, yy = 0, err = 2-2*r;
+typedef void (*lumen_row_edges)(lumen_renderer* renderer, int32_t left, int32_t right, int32_t y, uint8_t first);
+
+static void lumen_plot_row_edges(lumen_renderer* renderer, int32_t left, int32_t right, int32_t y, uint8_t first){
+	lumen_render_set_pixel(renderer, left, y, renderer->render_color);
+	if (right != left) lumen_render_set_pixel(renderer, right, y, renderer->render_color);
+}
+
+static void lumen_fill_row_edges(lumen_renderer* renderer, int32_t left, int32_t right, int32_t y, uint8_t first){
+	// stepping reaches a row at its widest first, later edges on that row lie inside the span
+	if (first) lumen_render_draw_span(renderer, left, right, y);
+}
+
+static void lumen_circle_rows(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r, lumen_row_edges row){
+	// midpoint stepping over one quadrant, each step yields the mirrored edges of rows y+yy and y-yy
+	int32_t xx = -r, yy = 0, err = 2-2*r, last = -1;
 	do{
-		lumen_render_set_pixel(renderer, x-xx, y+yy, renderer->render_color);
-		lumen_render_set_pixel(renderer, x-yy, y-xx, renderer->render_color);
-		lumen_render_set_pixel(renderer, x+xx, y-yy, renderer->render_color);
-		lumen_render_set_pixel(renderer, x+yy, y+xx, renderer->render_color);
+		row(renderer, x+xx, x-xx, y+yy, yy != last);
+		if (yy != 0) row(renderer, x+xx, x-xx, y-yy, yy != last);
+		last = yy;
 		r = err;
 		if (r <= yy) err += ++yy*2+1;
 		if (r > xx || err > yy) err += ++xx*2+1;
 	}while(xx<0);
+	row(renderer, x, x, y+yy, yy != last);
+	if (yy != 0) row(renderer, x, x, y-yy, yy != last);
 }
 
-void lumen_render_draw_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2){
-	int32_t a = abs(x2-x1);
-	int32_t b = abs(y2-y1);
-	int32_t b1 = b&1;
+static void lumen_ellipse_rows(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2, lumen_row_edges row){
+	// midpoint stepping outward from the center rows, y1 walks down and y2 walks up
+	int64_t a = abs(x2-x1);
+	int64_t b = abs(y2-y1);
+	int64_t b1 = b&1;
 	int64_t dx = 4*(1-a)*b*b;
 	int64_t dy = 4*(b1+1)*a*a;
 	int64_t err = dx+dy+b1*a*a;
@@ -174,11 +879,11 @@ void lumen_render_draw_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1,
 	y2 = y1-b1;
 	a *= 8*a;
 	b1 = 8*b*b;
+	int32_t last = y2-1;
 	do{
-		lumen_render_set_pixel(renderer, x2, y1, renderer->render_color);
-		lumen_render_set_pixel(renderer, x1, y1, renderer->render_color);
-		lumen_render_set_pixel(renderer, x1, y2, renderer->render_color);
-		lumen_render_set_pixel(renderer, x2, y2, renderer->render_color);
+		row(renderer, x1, x2, y1, y1 != last);
+		if (y2 != y1) row(renderer, x1, x2, y2, y1 != last);
+		last = y1;
 		e2 = 2*err;
 		if (e2 <= dy){
 			y1++;
@@ -192,13 +897,19 @@ void lumen_render_draw_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1,
 		}
 	}while(x1 <= x2);
 	while(y1-y2 < b){
-		lumen_render_set_pixel(renderer, x1-1, y1, renderer->render_color);
-		lumen_render_set_pixel(renderer, x2+1, y1++, renderer->render_color);
-		lumen_render_set_pixel(renderer, x1-1, y2, renderer->render_color);
-		lumen_render_set_pixel(renderer, x2+1, y2--, renderer->render_color);
+		row(renderer, x1-1, x2+1, y1++, 1);
+		row(renderer, x1-1, x2+1, y2--, 1);
 	}
 }
 
+void lumen_render_draw_circle(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r){
+	lumen_circle_rows(renderer, x, y, r, lumen_plot_row_edges);
+}
+
+void lumen_render_draw_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2){
+	lumen_ellipse_rows(renderer, x1, y1, x2, y2, lumen_plot_row_edges);
+}
+
 void lumen_render_draw_rect(lumen_renderer* renderer, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2){
 	lumen_render_draw_line(renderer, x1, y1, x2, y1);
 	lumen_render_draw_line(renderer, x1, y1, x1, y2);
@@ -206,6 +917,144 @@ void lumen_render_draw_rect(lumen_renderer* renderer, uint32_t x1, uint32_t y1,
 	lumen_render_draw_line(renderer, x2, y2, x2, y1);
 }
 
+void lumen_render_draw_span(lumen_renderer* renderer, int32_t x1, int32_t x2, int32_t y){
+	if (y < 0 || y >= (int32_t)renderer->h) return;
+	if (x1 > x2){
+		int32_t t = x1;
+		x1 = x2;
+		x2 = t;
+	}
+	if (x1 < 0) x1 = 0;
+	if (x2 >= (int32_t)renderer->w) x2 = renderer->w-1;
+	if (x1 > x2) return;
+	uint32_t color = renderer->render_color;
+	if (renderer->blendmode == LUMEN_BLENDMODE_NONE || (color & 0xff) == 0xff){
+		uint32_t* row = renderer->pixels+(y*renderer->w);
+		int32_t x;
+		for (x = x1;x<=x2;++x){
+			row[x] = color;
+		}
+		return;
+	}
+	int32_t x;
+	for (x = x1;x<=x2;++x){
+		lumen_render_set_pixel(renderer, x, y, color);
+	}
+}
+
+void lumen_render_fill_circle(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r){
+	lumen_circle_rows(renderer, x, y, r, lumen_fill_row_edges);
+}
+
+void lumen_render_fill_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2){
+	lumen_ellipse_rows(renderer, x1, y1, x2, y2, lumen_fill_row_edges);
+}
+
+void lumen_render_fill_rect(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2){
+	if (y1 > y2){
+		int32_t t = y1;
+		y1 = y2;
+		y2 = t;
+	}
+	if (y1 < 0) y1 = 0;
+	if (y2 >= (int32_t)renderer->h) y2 = renderer->h-1;
+	for (;y1<=y2;++y1){
+		lumen_render_draw_span(renderer, x1, x2, y1);
+	}
+}
+
+typedef struct lumen_edge{
+	float x;
+	float dxdy;
+	int32_t ymin;
+	int32_t ymax;
+	int32_t winding;
+}lumen_edge;
+
+static int lumen_edge_compare_ymin(const void* a, const void* b){
+	return ((lumen_edge*)a)->ymin - ((lumen_edge*)b)->ymin;
+}
+
+void lumen_render_fill_polygon(lumen_renderer* renderer, v2* points, uint32_t count, LUMEN_FILL_RULE rule){
+	// active edge table scanline fill, sampled at pixel centers
+	if (count < 3) return;
+	lumen_edge* edges = malloc(sizeof(lumen_edge)*count);
+	lumen_edge** active = malloc(sizeof(lumen_edge*)*count);
+	uint32_t i, k, n = 0, active_count = 0;
+	for (i = 0;i<count;++i){
+		v2 a = points[i];
+		v2 b = points[(i+1)%count];
+		int32_t winding = 1;
+		if (a.y > b.y){
+			v2 t = a;
+			a = b;
+			b = t;
+			winding = -1;
+		}
+		int32_t ymin = (int32_t)ceil(a.y-0.5f);
+		int32_t ymax = (int32_t)ceil(b.y-0.5f);
+		if (ymin >= ymax) continue;
+		lumen_edge* edge = &edges[n++];
+		edge->dxdy = (b.x-a.x)/(b.y-a.y);
+		edge->x = a.x + ((ymin+0.5f)-a.y)*edge->dxdy;
+		edge->ymin = ymin;
+		edge->ymax = ymax;
+		edge->winding = winding;
+	}
+	if (n == 0){
+		free(edges);
+		free(active);
+		return;
+	}
+	qsort(edges, n, sizeof(lumen_edge), lumen_edge_compare_ymin);
+	int32_t y = edges[0].ymin;
+	int32_t bottom = renderer->h;
+	uint32_t next = 0;
+	while ((next < n || active_count > 0) && y < bottom){
+		for (;next<n && edges[next].ymin == y;++next){
+			active[active_count++] = &edges[next];
+		}
+		for (i = 0, k = 0;i<active_count;++i){
+			if (active[i]->ymax > y){
+				active[k++] = active[i];
+			}
+		}
+		active_count = k;
+		for (i = 1;i<active_count;++i){
+			lumen_edge* edge = active[i];
+			for (k = i;k>0 && active[k-1]->x > edge->x;--k){
+				active[k] = active[k-1];
+			}
+			active[k] = edge;
+		}
+		if (y >= 0){
+			int32_t winding = 0;
+			for (i = 0;i+1<active_count;++i){
+				if (rule == LUMEN_FILL_NONZERO){
+					winding += active[i]->winding;
+				}
+				else{
+					winding ^= 1;
+				}
+				if (winding != 0){
+					int32_t xa = (int32_t)ceil(active[i]->x-0.5f);
+					int32_t xb = (int32_t)ceil(active[i+1]->x-0.5f)-1;
+					if (xa <= xb) lumen_render_draw_span(renderer, xa, xb, y);
+				}
+			}
+		}
+		for (i = 0;i<active_count;++i){
+			active[i]->x += active[i]->dxdy;
+		}
+		y++;
+		if (active_count == 0 && next < n){
+			y = edges[next].ymin;
+		}
+	}
+	free(edges);
+	free(active);
+}
+
 void lumen_render_draw_line_v2(lumen_renderer* renderer, v2 a, v2 b){
 	lumen_render_draw_line(renderer, a.x, a.y, b.x, b.y);
 }
@@ -327,6 +1176,171 @@ void lumen_texture_free(lumen_texture* texture){
 	texture->pixels = NULL;
 }
 
+// 3x5 printable ascii, one glyph per entry, rows top to bottom, 3 bits per row msb first
+static const uint16_t lumen_font_default_glyphs[FONT_DEFAULT_COUNT] = {
+	0x0000, 0x2482, 0x5a00, 0x5f7d, 0x3c9e, 0x52a5, 0x2aab, 0x2400,
+	0x1491, 0x4494, 0x0aa8, 0x05d0, 0x0014, 0x01c0, 0x0002, 0x12a4,
+	0x7b6f, 0x2c97, 0x73e7, 0x72cf, 0x5bc9, 0x79cf, 0x79ef, 0x7252,
+	0x7bef, 0x7bcf, 0x0410, 0x0414, 0x1511, 0x0e38, 0x4454, 0x72c2,
+	0x7be3, 0x2bed, 0x6bae, 0x3923, 0x6b6e, 0x79a7, 0x79a4, 0x396b,
+	0x5bed, 0x7497, 0x126a, 0x5bad, 0x4927, 0x5fed, 0x6b6d, 0x2b6a,
+	0x6ba4, 0x2b73, 0x6bad, 0x388e, 0x7492, 0x5b6b, 0x5b52, 0x5bfd,
+	0x5aad, 0x5a92, 0x72a7, 0x6926, 0x4889, 0x324b, 0x2a00, 0x0007,
+	0x4400, 0x076b, 0x4d6e, 0x0723, 0x176b, 0x07e3, 0x15d2, 0x075e,
+	0x4d6d, 0x2092, 0x106a, 0x4bb5, 0x6497, 0x0fed, 0x0d6d, 0x056a,
+	0x0d74, 0x0759, 0x0724, 0x078e, 0x2e91, 0x0b6b, 0x0b52, 0x0bfa,
+	0x0a95, 0x0ace, 0x0ee7, 0x3593, 0x2492, 0x64d6, 0x03e0,
+};
+
+static lumen_font lumen_font_create(uint32_t glyph_w, uint32_t glyph_h, uint32_t first, uint32_t count){
+	lumen_font font;
+	font.glyph_w = glyph_w;
+	font.glyph_h = glyph_h;
+	font.first = first;
+	font.count = count;
+	font.atlas_stride = ((glyph_w*count)+7)/8;
+	font.atlas = calloc(font.atlas_stride*glyph_h, sizeof(uint8_t));
+	font.spans = NULL;
+	font.span_start = NULL;
+	return font;
+}
+
+static void lumen_font_set_bit(lumen_font* font, uint32_t glyph, uint32_t x, uint32_t y){
+	uint32_t bit = (glyph*font->glyph_w)+x;
+	font->atlas[(y*font->atlas_stride)+(bit/8)] |= 0x80 >> (bit%8);
+}
+
+static uint8_t lumen_font_get_bit(lumen_font* font, uint32_t glyph, uint32_t x, uint32_t y){
+	uint32_t bit = (glyph*font->glyph_w)+x;
+	return (font->atlas[(y*font->atlas_stride)+(bit/8)] >> (7-(bit%8))) & 1;
+}
+
+static void lumen_font_cache_spans(lumen_font* font){
+	// walk the atlas once so drawing only replays runs of set bits
+	uint32_t g, x, y, n = 0, cap = font->count+1;
+	font->span_start = malloc(sizeof(uint32_t)*(font->count+1));
+	font->spans = malloc(sizeof(lumen_glyph_span)*cap);
+	for (g = 0;g<font->count;++g){
+		font->span_start[g] = n;
+		for (y = 0;y<font->glyph_h;++y){
+			for (x = 0;x<font->glyph_w;++x){
+				if (!lumen_font_get_bit(font, g, x, y)) continue;
+				uint32_t start = x;
+				while (x<font->glyph_w && lumen_font_get_bit(font, g, x, y)) ++x;
+				if (n == cap){
+					cap *= 2;
+					font->spans = realloc(font->spans, sizeof(lumen_glyph_span)*cap);
+				}
+				font->spans[n].x = start;
+				font->spans[n].y = y;
+				font->spans[n].len = x-start;
+				n++;
+			}
+		}
+	}
+	font->span_start[font->count] = n;
+}
+
+lumen_font lumen_font_default(){
+	lumen_font font = lumen_font_create(FONT_DEFAULT_W, FONT_DEFAULT_H, FONT_DEFAULT_FIRST, FONT_DEFAULT_COUNT);
+	uint32_t g, x, y;
+	for (g = 0;g<FONT_DEFAULT_COUNT;++g){
+		uint16_t glyph = lumen_font_default_glyphs[g];
+		for (y = 0;y<FONT_DEFAULT_H;++y){
+			for (x = 0;x<FONT_DEFAULT_W;++x){
+				uint32_t bit = (FONT_DEFAULT_W*FONT_DEFAULT_H)-1-((y*FONT_DEFAULT_W)+x);
+				if ((glyph >> bit) & 1){
+					lumen_font_set_bit(&font, g, x, y);
+				}
+			}
+		}
+	}
+	lumen_font_cache_spans(&font);
+	return font;
+}
+
+lumen_font lumen_font_load(const char* src, uint32_t glyph_w, uint32_t glyph_h, uint32_t first){
+	// glyph sheet read left to right, top to bottom, any channel at half intensity or above sets a bit
+	lumen_texture sheet = lumen_texture_load(src);
+	uint32_t columns = glyph_w == 0 ? 0 : sheet.w/glyph_w;
+	uint32_t rows = glyph_h == 0 ? 0 : sheet.h/glyph_h;
+	lumen_font font = lumen_font_create(glyph_w, glyph_h, first, columns*rows);
+	if (sheet.pixels == NULL || font.count == 0){
+		fprintf(stderr, "\033[1mLumen\033[0m could not build a font from %s\n", src);
+		lumen_texture_free(&sheet);
+		lumen_font_cache_spans(&font);
+		return font;
+	}
+	uint32_t g, x, y;
+	for (g = 0;g<font.count;++g){
+		uint32_t sx = (g%columns)*glyph_w;
+		uint32_t sy = (g/columns)*glyph_h;
+		for (y = 0;y<glyph_h;++y){
+			for (x = 0;x<glyph_w;++x){
+				uint32_t pixel = sheet.pixels[((sy+y)*sheet.w)+sx+x];
+				if ((pixel & 0x80808000) != 0){
+					lumen_font_set_bit(&font, g, x, y);
+				}
+			}
+		}
+	}
+	lumen_texture_free(&sheet);
+	lumen_font_cache_spans(&font);
+	return font;
+}
+
+void lumen_font_free(lumen_font* font){
+	free(font->atlas);
+	free(font->spans);
+	free(font->span_start);
+	font->atlas = NULL;
+	font->spans = NULL;
+	font->span_start = NULL;
+}
+
+void lumen_render_draw_text(lumen_renderer* renderer, lumen_font* font, int32_t x, int32_t y, const char* text){
+	int32_t xx = x;
+	for (;*text != '\0';++text){
+		uint8_t c = *text;
+		if (c == '\n'){
+			xx = x;
+			y += font->glyph_h+1;
+			continue;
+		}
+		if (c >= font->first && c < font->first+font->count){
+			uint32_t g = c-font->first;
+			uint32_t i;
+			for (i = font->span_start[g];i<font->span_start[g+1];++i){
+				lumen_glyph_span span = font->spans[i];
+				lumen_render_draw_span(renderer, xx+span.x, xx+span.x+span.len-1, y+span.y);
+			}
+		}
+		xx += font->glyph_w+1;
+	}
+}
+
+void lumen_render_draw_text_cells(lumen_renderer* renderer, uint32_t x, uint32_t y, const char* text){
+	// x counts terminal columns, two to a presented pixel, y counts rows
+	uint32_t columns = renderer->present_w*2;
+	if (renderer->text == NULL){
+		renderer->text = calloc(columns*renderer->present_h, sizeof(char));
+		renderer->text_color = calloc(renderer->present_w*renderer->present_h, sizeof(uint32_t));
+	}
+	uint32_t xx = x;
+	for (;*text != '\0';++text){
+		if (*text == '\n'){
+			xx = x;
+			y++;
+			continue;
+		}
+		if (xx < columns && y < renderer->present_h){
+			renderer->text[(y*columns)+xx] = *text;
+			renderer->text_color[(y*renderer->present_w)+(xx/2)] = renderer->render_color;
+		}
+		xx++;
+	}
+}
+
 void lumen_render_draw_texture(lumen_renderer* renderer, lumen_texture texture, int32_t x, int32_t y){
 	int32_t xx, yy;
 	int32_t xc = x+texture.origin_x;
@@ -3,12 +3,27 @@
 
 #include <inttypes.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
 #include <linux/input.h>
 #include <termios.h>
 
 #define READ_BUFFER_SIZE 16
 #define KEY_READ_COUNT 128
 #define INPUT_EVENT_FILE "/dev/input/by-path/platform-i8042-serio-0-event-kbd"
+#define DOWNSAMPLE_THREAD_COUNT 4
+#define DOWNSAMPLE_THREAD_MIN_ROWS 64
+#define FONT_DEFAULT_W 3
+#define FONT_DEFAULT_H 5
+#define FONT_DEFAULT_FIRST 32
+#define FONT_DEFAULT_COUNT 95
+#define SHM_MAGIC 0x4c554d4e
+#define SHM_READ_RETRIES 64
+#define RECORD_MAGIC 0x4c554d52
+#define RECORD_VERSION 1
+#define RECORD_QUEUE_FRAMES 8
+#define RECORD_KEYFRAME_INTERVAL 60
+#define RECORD_WRITE_BATCH (1<<20)
 
 typedef enum LUMEN_INPUT_EVENT_VALUE{
 	LUMEN_INPUT_RELEASED = 0,
@@ -21,6 +36,11 @@ typedef enum LUMEN_BLENDMODE{
 	LUMEN_BLENDMODE_ALPHA
 }LUMEN_BLENDMODE;
 
+typedef enum LUMEN_FILL_RULE{
+	LUMEN_FILL_EVEN_ODD,
+	LUMEN_FILL_NONZERO
+}LUMEN_FILL_RULE;
+
 typedef enum LUMEN_FILE_TYPE{
 	LUMEN_READ_NONE,
 	LUMEN_READ_PNG,
@@ -28,6 +48,23 @@ typedef enum LUMEN_FILE_TYPE{
 	LUMEN_READ_PPM
 }LUMEN_FILE_TYPE;
 
+// ordering: the writer only stores into a slot after a publish moved front off it,
+// and a full fence after that publish's sequence store keeps those pixel stores behind it,
+// so a reader that copied a slot being reused always sees a changed sequence and retries
+typedef struct lumen_shm_header{
+	uint32_t magic;
+	uint32_t w;
+	uint32_t h;
+	// odd while the writer is swapping slots
+	uint32_t sequence;
+	// slot readers should copy from, the writer draws into the other one
+	uint32_t front;
+	uint32_t pad;
+	uint64_t frame;
+}lumen_shm_header;
+
+typedef struct lumen_downsample_pool lumen_downsample_pool;
+
 typedef struct lumen_renderer{
 	// rgba
 	uint32_t* pixels;
@@ -35,8 +72,28 @@ typedef struct lumen_renderer{
 	uint32_t h;
 	uint32_t render_color;
 	LUMEN_BLENDMODE blendmode;
+	// presented resolution, pixels is scale times larger on each axis
+	uint32_t* present;
+	uint32_t present_w;
+	uint32_t present_h;
+	uint32_t scale;
+	// terminal cell text, two cells per presented pixel, allocated on first use
+	char* text;
+	uint32_t* text_color;
+	// presented frames double buffered in shared memory, NULL when private
+	lumen_shm_header* shared;
+	size_t shared_size;
+	char* shared_name;
+	// persistent downsample workers, NULL when the calling thread does it alone
+	lumen_downsample_pool* downsample;
 }lumen_renderer;
 
+typedef struct lumen_shm_reader{
+	lumen_shm_header* header;
+	size_t size;
+	uint64_t frame;
+}lumen_shm_reader;
+
 typedef struct lumen_texture{
 	uint32_t* pixels;
 	uint32_t w;
@@ -48,6 +105,68 @@ typedef struct lumen_texture{
 	float scale_y;
 }lumen_texture;
 
+typedef struct lumen_glyph_span{
+	uint16_t x;
+	uint16_t y;
+	uint16_t len;
+}lumen_glyph_span;
+
+typedef struct lumen_font{
+	// 1bpp, glyphs side by side, rows padded to whole bytes
+	uint8_t* atlas;
+	uint32_t atlas_stride;
+	// horizontal runs of each glyph, glyph i owns spans[span_start[i]] to spans[span_start[i+1]]
+	lumen_glyph_span* spans;
+	uint32_t* span_start;
+	uint32_t glyph_w;
+	uint32_t glyph_h;
+	uint32_t first;
+	uint32_t count;
+}lumen_font;
+
+typedef struct lumen_record_header{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t w;
+	uint32_t h;
+	uint32_t frame_count;
+	uint32_t keyframe_interval;
+	// file offset of frame_count uint64_t frame offsets, 0 until the recording is closed
+	uint64_t index_offset;
+}lumen_record_header;
+
+typedef struct lumen_recorder{
+	FILE* file;
+	lumen_record_header header;
+	// ring of frames waiting for the writer thread
+	uint32_t* queue;
+	uint32_t queue_head;
+	uint32_t queue_tail;
+	uint32_t queued;
+	uint32_t dropped;
+	uint8_t running;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t ready;
+	// writer thread state
+	uint32_t* previous;
+	uint32_t* encoded;
+	uint8_t* batch;
+	size_t batch_len;
+	uint64_t offset;
+	uint64_t* index;
+	uint32_t index_cap;
+}lumen_recorder;
+
+typedef struct lumen_player{
+	FILE* file;
+	lumen_record_header header;
+	uint64_t* index;
+	uint32_t* frame;
+	uint32_t* encoded;
+	uint32_t current;
+}lumen_player;
+
 typedef struct lumen_input{
 	uint8_t term_saved;
 	uint8_t key_pressed[KEY_READ_COUNT];
@@ -80,7 +199,9 @@ v4 v4_v2(v2 a, v2 b);
 void rotate_v2(v2 origin, v2* point, float angle);
 
 void lumen_renderer_init(lumen_renderer* renderer, uint32_t w, uint32_t h);
+void lumen_renderer_init_supersampled(lumen_renderer* renderer, uint32_t w, uint32_t h, uint32_t scale);
 void lumen_renderer_free(lumen_renderer* renderer);
+int32_t lumen_renderer_share(lumen_renderer* renderer, const char* name);
 
 void lumen_render_set_color_rgb(lumen_renderer* renderer, uint8_t r, uint8_t g, uint8_t b);
 void lumen_render_set_color_hex(lumen_renderer* renderer, uint32_t color);
@@ -94,6 +215,11 @@ void lumen_render_draw_line_v2(lumen_renderer* renderer, v2 a, v2 b);
 void lumen_render_draw_circle(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r);
 void lumen_render_draw_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 void lumen_render_draw_rect(lumen_renderer* renderer, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2);
+void lumen_render_draw_span(lumen_renderer* renderer, int32_t x1, int32_t x2, int32_t y);
+void lumen_render_fill_circle(lumen_renderer* renderer, int32_t x, int32_t y, int32_t r);
+void lumen_render_fill_ellipse(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void lumen_render_fill_rect(lumen_renderer* renderer, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void lumen_render_fill_polygon(lumen_renderer* renderer, v2* points, uint32_t count, LUMEN_FILL_RULE rule);
 void lumen_render_draw_texture(lumen_renderer* renderer, lumen_texture texture, int32_t x, int32_t y);
 void lumen_render_draw_triangle_wireframe(lumen_renderer* renderer, v2 a, v2 b, v2 c);
 void lumen_render_draw_triangle(lumen_renderer* renderer, v2 a, v2 b, v2 c);
@@ -102,10 +228,31 @@ uint8_t check_image_file_header(char* bytes, uint8_t* header, size_t len);
 lumen_texture lumen_texture_load(const char* src);
 void lumen_texture_free(lumen_texture* texture);
 
+lumen_font lumen_font_default();
+lumen_font lumen_font_load(const char* src, uint32_t glyph_w, uint32_t glyph_h, uint32_t first);
+void lumen_font_free(lumen_font* font);
+void lumen_render_draw_text(lumen_renderer* renderer, lumen_font* font, int32_t x, int32_t y, const char* text);
+void lumen_render_draw_text_cells(lumen_renderer* renderer, uint32_t x, uint32_t y, const char* text);
+
+void lumen_render_downsample(lumen_renderer* renderer);
 void lumen_render_put(lumen_renderer* renderer);
+void lumen_render_publish(lumen_renderer* renderer);
+
+int32_t lumen_shm_reader_open(lumen_shm_reader* reader, const char* name);
+uint8_t lumen_shm_reader_read(lumen_shm_reader* reader, uint32_t* dest);
+void lumen_shm_reader_close(lumen_shm_reader* reader);
+
+int32_t lumen_recorder_open(lumen_recorder* recorder, const char* dest, uint32_t w, uint32_t h);
+void lumen_recorder_capture(lumen_recorder* recorder, lumen_renderer* renderer);
+void lumen_recorder_close(lumen_recorder* recorder);
+int32_t lumen_player_open(lumen_player* player, const char* src);
+uint8_t lumen_player_next(lumen_player* player, lumen_renderer* renderer);
+void lumen_player_seek(lumen_player* player, uint32_t frame);
+void lumen_player_close(lumen_player* player);
 
 char* get_ascii_esc_from_color(uint32_t color);
 char* lumen_ascii_convert(uint32_t pixel);
+char* lumen_ascii_convert_text(uint32_t color, char left, char right);
 
 void lumen_input_init(lumen_input* input);
 void lumen_input_close(lumen_input* input);